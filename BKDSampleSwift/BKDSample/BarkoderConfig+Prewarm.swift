@@ -0,0 +1,54 @@
+//
+//  BarkoderConfig+Prewarm.swift
+//  BKDSample
+//
+
+import UIKit
+import BarkoderSDK
+
+extension BarkoderConfig {
+
+    /// Decodes a rendered code of an enabled symbology at the configured resolution, so the state the engine
+    /// creates lazily for `iBarkoder.decodeImage(inMemory:...)` exists before the first in-memory decode.
+    /// Live scanning goes through `decodeSampleBufferAsync` and its camera-side setup is not warmed by this.
+    ///
+    /// Nothing is decoded when no enabled symbology is in `SyntheticCode.all`, e.g. with only EAN/UPC enabled.
+    ///
+    /// Do not start scanning before `completion` is called, as it would enter the decoder concurrently.
+    func prewarm(completion: (() -> Void)? = nil) {
+        guard let decoderConfig = decoderConfig?.copy() as? Config,
+              let code = SyntheticCode.firstEnabled(in: decoderConfig) else {
+            completion?()
+            return
+        }
+
+        let size = barkoderResolution.frameSize
+
+        DispatchQueue.global(qos: .utility).async {
+            if var pixels = code.render(size: size) {
+                pixels.withUnsafeMutableBufferPointer { buffer in
+                    _ = iBarkoder.decodeImage(inMemory: decoderConfig, imagePixels: buffer.baseAddress,
+                                              imageWidth: Int32(size.width), imageHeight: Int32(size.height),
+                                              colorFormat: Grayscale)
+                }
+            }
+
+            DispatchQueue.main.async {
+                completion?()
+            }
+        }
+    }
+}
+
+extension BarkoderView.BarkoderResolution {
+
+    /// Landscape camera frame size delivered for this resolution
+    var frameSize: CGSize {
+        switch self {
+        case .HD: return CGSize(width: 1280, height: 720)
+        case .FHD: return CGSize(width: 1920, height: 1080)
+        case .UHD: return CGSize(width: 3840, height: 2160)
+        @unknown default: return CGSize(width: 1920, height: 1080)
+        }
+    }
+}
@@ -0,0 +1,338 @@
+//
+//  DecodeBenchmark.swift
+//  BKDSample
+//
+
+import UIKit
+import BarkoderSDK
+
+/// Runs `iBarkoder.decodeImage(inMemory:...)` over a synthetic, reproducible corpus and
+/// prints latency percentiles, decodes-per-second and miss rate for every decoding speed.
+/// Further passes decode the same frames as BGRA, to compare against Grayscale input,
+/// and with `GlobalOption_UseGPU` on and off, to compare the Metal and CPU paths. A last pass
+/// compares the default result limits with `maximumResultsCount` and `expectedCount` capped to one.
+///
+/// Launch the sample with the `-BKDDecodeBenchmark` argument to run it. The main pass is repeated for
+/// each `GlobalOption_SetMaximumThreads` value given as `-BKDDecodeBenchmarkThreads 1,2,4`.
+final class DecodeBenchmark {
+
+    // MARK: - Types
+
+    struct Report {
+        let sample: String
+        let resolution: BarkoderView.BarkoderResolution
+        let speed: DecodingSpeed
+        let colorFormat: ColorFormat
+        let threads: Int
+        let gpu: Bool
+        let latenciesMs: [Double]
+        let misses: Int
+
+        var p50: Double { percentile(0.50) }
+        var p95: Double { percentile(0.95) }
+        /// Left out below 100 samples, where it would only repeat the slowest decode
+        var p99: Double? { latenciesMs.count >= 100 ? percentile(0.99) : nil }
+
+        var decodesPerSecond: Double {
+            let totalMs = latenciesMs.reduce(0, +)
+            return totalMs > 0 ? Double(latenciesMs.count) * 1000 / totalMs : 0
+        }
+
+        var missRate: Double {
+            latenciesMs.isEmpty ? 0 : Double(misses) / Double(latenciesMs.count)
+        }
+
+        private func percentile(_ p: Double) -> Double {
+            guard !latenciesMs.isEmpty else { return 0 }
+            let sorted = latenciesMs.sorted()
+            let rank = Int((p * Double(sorted.count)).rounded(.up)) - 1
+            return sorted[min(max(rank, 0), sorted.count - 1)]
+        }
+    }
+
+    // MARK: - Constants
+
+    static let launchArgument = "-BKDDecodeBenchmark"
+
+    static let resolutions: [BarkoderView.BarkoderResolution] = [.HD, .FHD, .UHD]
+    static let speeds: [DecodingSpeed] = [Fast, Normal, Slow, Rigorous]
+
+    // MARK: - Properties
+
+    private let baseConfig: Config
+    private let iterations: Int
+    private let threadLimits: [Int]
+
+    // MARK: - Init
+
+    /// - Parameters:
+    ///   - config: Decoder config to copy for every run; its license is reused
+    ///   - iterations: Timed decodes per sample, resolution and speed; p99 needs at least 100
+    ///   - threadLimits: Values for `GlobalOption_SetMaximumThreads`, empty keeps the current one
+    init(config: Config, iterations: Int = 100, threadLimits: [Int] = []) {
+        self.baseConfig = config
+        self.iterations = iterations
+        self.threadLimits = threadLimits
+    }
+
+    static var isRequested: Bool {
+        ProcessInfo.processInfo.arguments.contains(launchArgument)
+    }
+
+    static let threadsLaunchArgument = "-BKDDecodeBenchmarkThreads"
+
+    /// Thread limits from `-BKDDecodeBenchmarkThreads`, otherwise a single thread and all active cores
+    static var requestedThreadLimits: [Int] {
+        let arguments = ProcessInfo.processInfo.arguments
+
+        if let index = arguments.firstIndex(of: threadsLaunchArgument), index + 1 < arguments.count {
+            let limits = arguments[index + 1].split(separator: ",")
+                .compactMap { Int($0.trimmingCharacters(in: .whitespaces)) }
+                .filter { $0 > 0 }
+            if !limits.isEmpty {
+                return limits
+            }
+        }
+
+        return Array(Set([1, ProcessInfo.processInfo.activeProcessorCount])).sorted()
+    }
+
+    // MARK: - Running
+
+    @discardableResult
+    func run() -> [Report] {
+        let originalThreads = Int(Config.getGlobalOption(GlobalOption_SetMaximumThreads))
+        let limits = threadLimits.isEmpty ? [originalThreads] : threadLimits
+        var reports: [Report] = []
+
+        print("[DecodeBenchmark] barKoder \(iBarkoder.GetVersion()), \(iterations) iterations")
+
+        for resolution in Self.resolutions {
+            let size = resolution.frameSize
+
+            for sample in SyntheticCode.all {
+                guard var frame = sample.render(size: size) else {
+                    print("[DecodeBenchmark] Unable to render \(sample.name) at \(Self.name(of: resolution))")
+                    continue
+                }
+
+                for threads in limits {
+                    Config.setGlobalOption(GlobalOption_SetMaximumThreads, value: Int32(threads))
+
+                    for speed in Self.speeds {
+                        let config = makeConfig(for: sample, speed: speed)
+                        let report = measure(sample, frame: &frame, size: size, resolution: resolution,
+                                             speed: speed, colorFormat: Grayscale, threads: threads, config: config)
+                        print(Self.format(report))
+                        reports.append(report)
+                    }
+                }
+            }
+        }
+
+        Config.setGlobalOption(GlobalOption_SetMaximumThreads, value: Int32(originalThreads))
+        return reports + runColorConversion() + runGPUComparison() + runResultCap()
+    }
+
+    /// Decodes identical frames as Grayscale and BGRA. The p50 delta covers the colour conversion plus reading
+    /// a four times larger frame, and single runs can come out negative from noise
+    private func runColorConversion() -> [Report] {
+        guard let sample = SyntheticCode.all.first else { return [] }
+        let threads = Int(Config.getGlobalOption(GlobalOption_SetMaximumThreads))
+        let config = makeConfig(for: sample, speed: Normal)
+        var reports: [Report] = []
+
+        for resolution in Self.resolutions {
+            let size = resolution.frameSize
+            guard var gray = sample.render(size: size) else { continue }
+            var bgra = Self.expandToBGRA(gray)
+
+            let grayReport = measure(sample, frame: &gray, size: size, resolution: resolution,
+                                     speed: Normal, colorFormat: Grayscale, threads: threads, config: config)
+            let bgraReport = measure(sample, frame: &bgra, size: size, resolution: resolution,
+                                     speed: Normal, colorFormat: BGRA, threads: threads, config: config)
+
+            print(Self.format(grayReport))
+            print(Self.format(bgraReport))
+            print(String(format: "[DecodeBenchmark] %@ %@ BGRA-Grayscale p50 delta=%.2fms",
+                         sample.name, Self.name(of: resolution), bgraReport.p50 - grayReport.p50))
+            reports += [grayReport, bgraReport]
+        }
+
+        return reports
+    }
+
+    /// Decodes identical frames with the GPU enabled and disabled, restoring the option afterwards.
+    /// Skipped when `GlobalOption_DisableGPUCompletely` is set, as both runs would take the CPU path
+    private func runGPUComparison() -> [Report] {
+        guard let sample = SyntheticCode.all.first else { return [] }
+        guard !Self.isGPUDisabledCompletely else {
+            print("[DecodeBenchmark] GPU comparison skipped, GlobalOption_DisableGPUCompletely is set")
+            return []
+        }
+
+        let originalGPU = Config.getGlobalOption(GlobalOption_UseGPU)
+        let threads = Int(Config.getGlobalOption(GlobalOption_SetMaximumThreads))
+        let config = makeConfig(for: sample, speed: Normal)
+        var reports: [Report] = []
+
+        for resolution in Self.resolutions {
+            let size = resolution.frameSize
+            guard var frame = sample.render(size: size) else { continue }
+            var p50: [Bool: Double] = [:]
+
+            for useGPU in [true, false] {
+                Config.setGlobalOption(GlobalOption_UseGPU, value: useGPU ? 1 : 0)
+                let report = measure(sample, frame: &frame, size: size, resolution: resolution,
+                                     speed: Normal, colorFormat: Grayscale, threads: threads, config: config)
+                print(Self.format(report))
+                p50[useGPU] = report.p50
+                reports.append(report)
+            }
+
+            print(String(format: "[DecodeBenchmark] %@ %@ GPU p50=%.2fms CPU p50=%.2fms",
+                         sample.name, Self.name(of: resolution), p50[true] ?? 0, p50[false] ?? 0))
+        }
+
+        Config.setGlobalOption(GlobalOption_UseGPU, value: originalGPU)
+        return reports
+    }
+
+    /// Decodes identical frames with the default result limits and with both limits capped to the single code
+    /// every corpus frame holds, letting the engine stop searching after the first result. Runs for every
+    /// speed, as the slower ones search the rest of the frame the longest
+    private func runResultCap() -> [Report] {
+        guard let sample = SyntheticCode.all.first else { return [] }
+        let threads = Int(Config.getGlobalOption(GlobalOption_SetMaximumThreads))
+        var reports: [Report] = []
+
+        for resolution in Self.resolutions {
+            let size = resolution.frameSize
+            guard var frame = sample.render(size: size) else { continue }
+
+            for speed in Self.speeds {
+                var p50: [Bool: Double] = [:]
+
+                for capResults in [false, true] {
+                    let config = makeConfig(for: sample, speed: speed, capResults: capResults)
+                    let report = measure(sample, frame: &frame, size: size, resolution: resolution,
+                                         speed: speed, colorFormat: Grayscale, threads: threads, config: config)
+                    print(Self.format(report))
+                    p50[capResults] = report.p50
+                    reports.append(report)
+                }
+
+                print(String(format: "[DecodeBenchmark] %@ %@ %@ uncapped p50=%.2fms capped p50=%.2fms",
+                             sample.name, Self.name(of: resolution), Self.name(of: speed),
+                             p50[false] ?? 0, p50[true] ?? 0))
+            }
+        }
+
+        return reports
+    }
+
+    private func measure(_ sample: SyntheticCode, frame: inout [UInt8], size: CGSize,
+                         resolution: BarkoderView.BarkoderResolution, speed: DecodingSpeed,
+                         colorFormat: ColorFormat, threads: Int, config: Config) -> Report {
+        let width = Int32(size.width)
+        let height = Int32(size.height)
+        var latencies: [Double] = []
+        var misses = 0
+
+        // Unlicensed decoders mask part of the text, so only the symbology can be checked for them
+        let checksPayload = config.getConfig(forDecoder: sample.decoderType).isLicensed()
+        let isHit: (BKDecoderResult) -> Bool = { result in
+            result.barcodeType == sample.barcodeType && (!checksPayload || result.textualData == SyntheticCode.payload)
+        }
+
+        frame.withUnsafeMutableBufferPointer { pixels in
+            // Warm-up decode, excluded from the statistics
+            _ = iBarkoder.decodeImage(inMemory: config, imagePixels: pixels.baseAddress,
+                                      imageWidth: width, imageHeight: height, colorFormat: colorFormat)
+
+            for _ in 0..<iterations {
+                let start = DispatchTime.now().uptimeNanoseconds
+                let results = iBarkoder.decodeImage(inMemory: config, imagePixels: pixels.baseAddress,
+                                                    imageWidth: width, imageHeight: height, colorFormat: colorFormat)
+                let end = DispatchTime.now().uptimeNanoseconds
+
+                latencies.append(Double(end - start) / 1_000_000)
+                if !(results ?? []).contains(where: isHit) {
+                    misses += 1
+                }
+            }
+        }
+
+        return Report(sample: sample.name, resolution: resolution, speed: speed, colorFormat: colorFormat,
+                      threads: threads,
+                      gpu: Config.getGlobalOption(GlobalOption_UseGPU) != 0 && !Self.isGPUDisabledCompletely,
+                      latenciesMs: latencies, misses: misses)
+    }
+
+    private func makeConfig(for sample: SyntheticCode, speed: DecodingSpeed, capResults: Bool = false) -> Config {
+        let config = baseConfig.copy() as! Config
+        config.setEnabledDecoders([NSNumber(value: sample.decoderType.rawValue)])
+        config.decodingSpeed = speed
+
+        if capResults {
+            config.maximumResultsCount = 1
+            config.getConfig(forDecoder: sample.decoderType).expectedCount = 1
+        }
+        return config
+    }
+
+    // MARK: - Frames
+
+    private static func expandToBGRA(_ gray: [UInt8]) -> [UInt8] {
+        var bgra = [UInt8](repeating: 255, count: gray.count * 4)
+        for (index, value) in gray.enumerated() {
+            bgra[index * 4] = value
+            bgra[index * 4 + 1] = value
+            bgra[index * 4 + 2] = value
+        }
+        return bgra
+    }
+
+    // MARK: - Helpers
+
+    /// Overrides `GlobalOption_UseGPU`, the engine then stays on the CPU path
+    private static var isGPUDisabledCompletely: Bool {
+        Config.getGlobalOption(GlobalOption_DisableGPUCompletely) != 0
+    }
+
+    static func name(of resolution: BarkoderView.BarkoderResolution) -> String {
+        switch resolution {
+        case .HD: return "HD"
+        case .FHD: return "FHD"
+        case .UHD: return "UHD"
+        @unknown default: return "?"
+        }
+    }
+
+    static func name(of speed: DecodingSpeed) -> String {
+        switch speed {
+        case Fast: return "Fast"
+        case Normal: return "Normal"
+        case Slow: return "Slow"
+        case Rigorous: return "Rigorous"
+        default: return "?"
+        }
+    }
+
+    static func name(of colorFormat: ColorFormat) -> String {
+        switch colorFormat {
+        case Grayscale: return "Grayscale"
+        case YUV: return "YUV"
+        case BGRA: return "BGRA"
+        default: return "?"
+        }
+    }
+
+    static func format(_ report: Report) -> String {
+        String(format: "[DecodeBenchmark] %@ %@ %@ %@ threads=%ld gpu=%@ p50=%.2fms p95=%.2fms p99=%@ dps=%.1f miss=%.1f%%",
+               report.sample, name(of: report.resolution), name(of: report.speed), name(of: report.colorFormat),
+               report.threads, report.gpu ? "on" : "off",
+               report.p50, report.p95, report.p99.map { String(format: "%.2fms", $0) } ?? "n/a",
+               report.decodesPerSecond, report.missRate * 100)
+    }
+}
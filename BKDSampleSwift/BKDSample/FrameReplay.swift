@@ -0,0 +1,343 @@
+//
+//  FrameReplay.swift
+//  BKDSample
+//
+
+import UIKit
+import BarkoderSDK
+
+/// Replays recorded frames through `iBarkoder.decodeImage(inMemory:...)` and prints per-frame
+/// results with load, queue-wait and decode timings, followed by a throughput summary.
+///
+/// Frames are read from `Documents/Replay`, sorted by file name. Image files are decoded one frame
+/// each; `.yuv` files hold consecutive NV12 or I420 frames and need the size in their name, for
+/// example `conveyor_1920x1080.yuv`. Loading and colour conversion run on their own queue, so
+/// they overlap with decoding of the previous frames.
+///
+/// Launch the sample with the `-BKDFrameReplay` argument to run it. Adding `-BKDFrameReplayTrace`
+/// also writes the load and decode spans of every frame to `Documents/replay-trace.json`, which
+/// opens in `chrome://tracing` or Perfetto.
+final class FrameReplay {
+
+    // MARK: - Types
+
+    struct Frame {
+        var index = 0
+        let name: String
+        var pixels: [UInt8]
+        let width: Int
+        let height: Int
+        var loadNs: UInt64 = 0
+        var enqueuedAt: UInt64 = 0
+    }
+
+    struct TraceEvent {
+        let name: String
+        let frame: String
+        let stage: Stage
+        let start: UInt64
+        let end: UInt64
+    }
+
+    enum Stage: Int, CaseIterable {
+        case load = 1
+        case decode
+
+        var name: String {
+            switch self {
+            case .load: return "load"
+            case .decode: return "decode"
+            }
+        }
+    }
+
+    struct Summary {
+        let frames: Int
+        let framesWithResults: Int
+        let results: Int
+        let resultsByType: [String: Int]
+        let loadMs: Double
+        let queueWaitMs: Double
+        let decodeMs: Double
+        let wallMs: Double
+
+        var framesPerSecond: Double { wallMs > 0 ? Double(frames) * 1000 / wallMs : 0 }
+        var meanLoadMs: Double { mean(loadMs) }
+        var meanQueueWaitMs: Double { mean(queueWaitMs) }
+        var meanDecodeMs: Double { mean(decodeMs) }
+
+        private func mean(_ totalMs: Double) -> Double {
+            frames > 0 ? totalMs / Double(frames) : 0
+        }
+    }
+
+    // MARK: - Constants
+
+    static let launchArgument = "-BKDFrameReplay"
+
+    static var defaultDirectory: URL {
+        FileManager.default.urls(for: .documentDirectory, in: .userDomainMask)[0]
+            .appendingPathComponent("Replay", isDirectory: true)
+    }
+
+    static let traceLaunchArgument = "-BKDFrameReplayTrace"
+
+    static var defaultTraceURL: URL {
+        FileManager.default.urls(for: .documentDirectory, in: .userDomainMask)[0]
+            .appendingPathComponent("replay-trace.json")
+    }
+
+    static var isRequested: Bool {
+        ProcessInfo.processInfo.arguments.contains(launchArgument)
+    }
+
+    static var isTraceRequested: Bool {
+        ProcessInfo.processInfo.arguments.contains(traceLaunchArgument)
+    }
+
+    // MARK: - Properties
+
+    private let config: Config
+    private let directory: URL
+    private let loadQueue = DispatchQueue(label: "com.barkoder.BKDSample.replay.load", qos: .userInitiated)
+
+    // Frames handed from the load stage to the decode stage, nil marks the end of the stream
+    private var pending: [Frame?] = []
+    private let pendingLock = NSLock()
+    private let freeSlots: DispatchSemaphore
+    private let loadedFrames = DispatchSemaphore(value: 0)
+
+    // Each stage only appends to its own buffer, the semaphores order them before the export
+    private let traceURL: URL?
+    private var loadEvents: [TraceEvent] = []
+    private var decodeEvents: [TraceEvent] = []
+
+    // MARK: - Init
+
+    /// - Parameters:
+    ///   - config: Decoder config used for every frame, copied so scanning settings stay untouched
+    ///   - directory: Folder with the recorded frames
+    ///   - queueDepth: Frames the load stage may prepare ahead of the decoder
+    ///   - traceURL: Destination of the Chrome trace JSON, nil disables tracing
+    init(config: Config, directory: URL = FrameReplay.defaultDirectory, queueDepth: Int = 3, traceURL: URL? = nil) {
+        self.config = config.copy() as! Config
+        self.directory = directory
+        self.freeSlots = DispatchSemaphore(value: max(1, queueDepth))
+        self.traceURL = traceURL
+    }
+
+    // MARK: - Running
+
+    /// Decodes every frame on the calling thread, blocking until the stream ends
+    @discardableResult
+    func run() -> Summary {
+        let files = (try? FileManager.default.contentsOfDirectory(at: directory, includingPropertiesForKeys: nil))?
+            .sorted { $0.lastPathComponent < $1.lastPathComponent } ?? []
+
+        print("[FrameReplay] \(files.count) files in \(directory.path)")
+
+        let start = DispatchTime.now().uptimeNanoseconds
+        loadQueue.async { [self] in
+            load(files)
+        }
+
+        var frames = 0
+        var framesWithResults = 0
+        var resultCount = 0
+        var resultsByType: [String: Int] = [:]
+        var loadNs: UInt64 = 0
+        var queueWaitNs: UInt64 = 0
+        var decodeNs: UInt64 = 0
+
+        while var frame = nextFrame() {
+            let width = Int32(frame.width)
+            let height = Int32(frame.height)
+
+            let decodeStart = DispatchTime.now().uptimeNanoseconds
+            let results: [DecoderResult] = frame.pixels.withUnsafeMutableBufferPointer { pixels in
+                iBarkoder.decodeImage(inMemory: config, imagePixels: pixels.baseAddress,
+                                      imageWidth: width, imageHeight: height, colorFormat: Grayscale) ?? []
+            }
+            let decodeEnd = DispatchTime.now().uptimeNanoseconds
+            freeSlots.signal()
+
+            if traceURL != nil {
+                decodeEvents.append(TraceEvent(name: "decode", frame: frame.name, stage: .decode,
+                                               start: decodeStart, end: decodeEnd))
+            }
+
+            let queueWait = decodeStart - frame.enqueuedAt
+            frames += 1
+            framesWithResults += results.isEmpty ? 0 : 1
+            resultCount += results.count
+            loadNs += frame.loadNs
+            queueWaitNs += queueWait
+            decodeNs += decodeEnd - decodeStart
+            results.forEach { resultsByType[$0.barcodeTypeName ?? "?", default: 0] += 1 }
+
+            let texts = results.map { "\($0.barcodeTypeName ?? "?"): \($0.textualData ?? "")" }
+            print(String(format: "[FrameReplay] #%ld %@ load=%.2fms wait=%.2fms decode=%.2fms %@",
+                         frame.index, frame.name, Self.milliseconds(frame.loadNs), Self.milliseconds(queueWait),
+                         Self.milliseconds(decodeEnd - decodeStart), texts.joined(separator: " | ")))
+        }
+
+        let summary = Summary(frames: frames, framesWithResults: framesWithResults, results: resultCount,
+                              resultsByType: resultsByType, loadMs: Self.milliseconds(loadNs),
+                              queueWaitMs: Self.milliseconds(queueWaitNs), decodeMs: Self.milliseconds(decodeNs),
+                              wallMs: Self.milliseconds(DispatchTime.now().uptimeNanoseconds - start))
+        print(String(format: "[FrameReplay] frames=%ld hits=%ld results=%ld fps=%.1f load=%.2fms wait=%.2fms decode=%.2fms/frame",
+                     summary.frames, summary.framesWithResults, summary.results, summary.framesPerSecond,
+                     summary.meanLoadMs, summary.meanQueueWaitMs, summary.meanDecodeMs))
+        summary.resultsByType.sorted { $0.key < $1.key }.forEach {
+            print("[FrameReplay] \($0.key): \($0.value)")
+        }
+
+        if let traceURL = traceURL {
+            writeTrace(to: traceURL, origin: start)
+        }
+        return summary
+    }
+
+    // MARK: - Pipeline
+
+    private func load(_ files: [URL]) {
+        var index = 0
+
+        func emit(_ frame: Frame) {
+            var frame = frame
+            frame.index = index
+            index += 1
+
+            if traceURL != nil {
+                let end = DispatchTime.now().uptimeNanoseconds
+                loadEvents.append(TraceEvent(name: "load", frame: frame.name, stage: .load,
+                                             start: end - frame.loadNs, end: end))
+            }
+            enqueue(frame)
+        }
+
+        for file in files {
+            if file.pathExtension.lowercased() == "yuv" {
+                loadRawFrames(file, emit)
+            } else if let frame = loadImage(file) {
+                emit(frame)
+            }
+        }
+
+        enqueue(nil)
+    }
+
+    private func enqueue(_ frame: Frame?) {
+        var frame = frame
+        if frame != nil {
+            freeSlots.wait()
+            frame?.enqueuedAt = DispatchTime.now().uptimeNanoseconds
+        }
+
+        pendingLock.lock()
+        pending.append(frame)
+        pendingLock.unlock()
+        loadedFrames.signal()
+    }
+
+    private func nextFrame() -> Frame? {
+        loadedFrames.wait()
+
+        pendingLock.lock()
+        defer { pendingLock.unlock() }
+        return pending.removeFirst()
+    }
+
+    // MARK: - Tracing
+
+    /// Writes complete ("X") events in the Chrome trace format, one track per pipeline stage
+    private func writeTrace(to url: URL, origin: UInt64) {
+        var events: [[String: Any]] = Stage.allCases.map { stage -> [String: Any] in
+            ["name": "thread_name", "ph": "M", "pid": 1, "tid": stage.rawValue, "args": ["name": stage.name]]
+        }
+
+        events += (loadEvents + decodeEvents).map { event -> [String: Any] in
+            ["name": event.name, "cat": "replay", "ph": "X", "pid": 1, "tid": event.stage.rawValue,
+             "ts": Double(event.start - origin) / 1000, "dur": Double(event.end - event.start) / 1000,
+             "args": ["frame": event.frame]]
+        }
+
+        do {
+            let data = try JSONSerialization.data(withJSONObject: ["traceEvents": events, "displayTimeUnit": "ms"])
+            try data.write(to: url, options: .atomic)
+            print("[FrameReplay] Trace written to \(url.path)")
+        } catch {
+            print("[FrameReplay] Unable to write trace: \(error)")
+        }
+    }
+
+    // MARK: - Sources
+
+    /// Renders an image file into a tightly packed 8-bit grayscale buffer
+    private func loadImage(_ file: URL) -> Frame? {
+        let loadStart = DispatchTime.now().uptimeNanoseconds
+        guard let image = UIImage(contentsOfFile: file.path)?.cgImage else { return nil }
+
+        let width = image.width
+        let height = image.height
+        var pixels = [UInt8](repeating: 0, count: width * height)
+
+        let drawn: Bool = pixels.withUnsafeMutableBytes { buffer in
+            guard let context = CGContext(data: buffer.baseAddress, width: width, height: height,
+                                          bitsPerComponent: 8, bytesPerRow: width,
+                                          space: CGColorSpaceCreateDeviceGray(),
+                                          bitmapInfo: CGImageAlphaInfo.none.rawValue) else { return false }
+
+            context.draw(image, in: CGRect(x: 0, y: 0, width: width, height: height))
+            return true
+        }
+
+        guard drawn else { return nil }
+
+        return Frame(name: file.lastPathComponent, pixels: pixels, width: width, height: height,
+                     loadNs: DispatchTime.now().uptimeNanoseconds - loadStart)
+    }
+
+    /// Reads consecutive NV12/I420 frames, keeping only the luma plane the decoder needs
+    private func loadRawFrames(_ file: URL, _ emit: (Frame) -> Void) {
+        guard let size = Self.frameSize(fromName: file.deletingPathExtension().lastPathComponent),
+              let handle = try? FileHandle(forReadingFrom: file) else {
+            print("[FrameReplay] Skipping \(file.lastPathComponent), expected <name>_<width>x<height>.yuv")
+            return
+        }
+        defer { try? handle.close() }
+
+        let lumaBytes = size.width * size.height
+        // 4:2:0 chroma planes round odd dimensions up, keeping the last row and column
+        let chromaBytes = 2 * ((size.width + 1) / 2) * ((size.height + 1) / 2)
+        var frameNumber = 0
+
+        while true {
+            let loadStart = DispatchTime.now().uptimeNanoseconds
+            guard let luma = try? handle.read(upToCount: lumaBytes), luma.count == lumaBytes else { break }
+
+            emit(Frame(name: "\(file.lastPathComponent)#\(frameNumber)", pixels: [UInt8](luma),
+                       width: size.width, height: size.height,
+                       loadNs: DispatchTime.now().uptimeNanoseconds - loadStart))
+            frameNumber += 1
+
+            // Only the luma plane is decoded, so the chroma planes are skipped rather than read
+            guard let offset = try? handle.offset(),
+                  (try? handle.seek(toOffset: offset + UInt64(chromaBytes))) != nil else { break }
+        }
+    }
+
+    private static func milliseconds(_ nanoseconds: UInt64) -> Double {
+        Double(nanoseconds) / 1_000_000
+    }
+
+    private static func frameSize(fromName name: String) -> (width: Int, height: Int)? {
+        guard let separator = name.lastIndex(of: "_") else { return nil }
+
+        let dimensions = name[name.index(after: separator)...].split(separator: "x")
+        guard dimensions.count == 2, let width = Int(dimensions[0]), let height = Int(dimensions[1]),
+              width > 0, height > 0 else { return nil }
+
+        return (width, height)
+    }
+}
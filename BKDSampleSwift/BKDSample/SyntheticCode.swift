@@ -0,0 +1,82 @@
+//
+//  SyntheticCode.swift
+//  BKDSample
+//
+
+import UIKit
+import CoreImage
+import BarkoderSDK
+
+/// A barcode CoreImage can render, so decodes can be run without bundled image files
+struct SyntheticCode {
+
+    // MARK: - Properties
+
+    let name: String
+    let decoderType: DecoderType
+    /// Type the decoder reports for this code
+    let barcodeType: BarcodeType
+    let filterName: String
+    let filterParameters: [String: Any]
+
+    // MARK: - Constants
+
+    static let all: [SyntheticCode] = [
+        SyntheticCode(name: "QR", decoderType: QR, barcodeType: BT_QR, filterName: "CIQRCodeGenerator",
+                      filterParameters: ["inputCorrectionLevel": "M"]),
+        // Compact Aztec is a separate decoder type, so the full-range format is forced
+        SyntheticCode(name: "Aztec", decoderType: Aztec, barcodeType: BT_Aztec, filterName: "CIAztecCodeGenerator",
+                      filterParameters: ["inputCorrectionLevel": 23.0, "inputCompactStyle": false]),
+        SyntheticCode(name: "PDF417", decoderType: PDF417, barcodeType: BT_PDF417, filterName: "CIPDF417BarcodeGenerator",
+                      filterParameters: [:]),
+        SyntheticCode(name: "Code128", decoderType: Code128, barcodeType: BT_Code128, filterName: "CICode128BarcodeGenerator",
+                      filterParameters: ["inputQuietSpace": 10.0])
+    ]
+
+    static let payload = "BKD-BENCH-0123456789"
+
+    // Shared by every render, creating a context is expensive
+    private static let ciContext = CIContext(options: [.useSoftwareRenderer: false])
+
+    // MARK: - Rendering
+
+    /// First code whose decoder is enabled in `config`, nil when none of them is
+    static func firstEnabled(in config: Config) -> SyntheticCode? {
+        let enabled = Set(config.getEnabledDecoders().map { $0.uint32Value })
+        return all.first { enabled.contains($0.decoderType.rawValue) }
+    }
+
+    /// Renders the code centered on a white frame as a tightly packed 8-bit grayscale buffer
+    func render(size: CGSize) -> [UInt8]? {
+        guard let filter = CIFilter(name: filterName) else { return nil }
+        filter.setValue(Self.payload.data(using: .ascii), forKey: "inputMessage")
+        filterParameters.forEach { filter.setValue($1, forKey: $0) }
+
+        guard let output = filter.outputImage,
+              let code = Self.ciContext.createCGImage(output, from: output.extent) else { return nil }
+
+        let width = Int(size.width)
+        let height = Int(size.height)
+        var pixels = [UInt8](repeating: 255, count: width * height)
+
+        let drawn: Bool = pixels.withUnsafeMutableBytes { buffer in
+            guard let context = CGContext(data: buffer.baseAddress, width: width, height: height,
+                                          bitsPerComponent: 8, bytesPerRow: width,
+                                          space: CGColorSpaceCreateDeviceGray(),
+                                          bitmapInfo: CGImageAlphaInfo.none.rawValue) else { return false }
+
+            // Fill about 40% of the frame height with whole-pixel modules, keeping wide 1D and PDF417 codes inside the frame
+            let scale = max(1, floor(min(size.height * 0.4 / CGFloat(code.height),
+                                         size.width * 0.8 / CGFloat(code.width))))
+            let codeSize = CGSize(width: CGFloat(code.width) * scale, height: CGFloat(code.height) * scale)
+            let origin = CGPoint(x: floor((size.width - codeSize.width) / 2),
+                                 y: floor((size.height - codeSize.height) / 2))
+
+            context.interpolationQuality = .none
+            context.draw(code, in: CGRect(origin: origin, size: codeSize))
+            return true
+        }
+
+        return drawn ? pixels : nil
+    }
+}
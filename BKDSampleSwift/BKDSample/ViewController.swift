@@ -47,6 +47,7 @@ final class ViewController: UIViewController {
         createBarkoderConfig()
         setActiveBarcodeTypes()
         setBarkoderSettings()
+        prewarmDecoder()
     }
     
     // MARK: - Private methods
@@ -108,6 +109,41 @@ final class ViewController: UIViewController {
         config.pinchToZoomEnabled = true
         try? config.setRegionOfInterest(CGRect(x: 5, y: 5, width: 90, height: 90))
     }
+    
+    private func prewarmDecoder() {
+        guard let config = barkoderView.config else { return }
+        
+        // Scanning is enabled once the prewarm decode has finished, so it never enters the decoder concurrently
+        scanButton.isEnabled = false
+        
+        config.prewarm { [weak self] in
+            self?.scanButton.isEnabled = true
+            self?.runDiagnosticsIfRequested()
+        }
+    }
+    
+    private func runDiagnosticsIfRequested() {
+        // Started with the -BKDDecodeBenchmark and -BKDFrameReplay launch arguments, results are printed to the console
+        guard DecodeBenchmark.isRequested || FrameReplay.isRequested,
+              let decoderConfig = barkoderView.config?.decoderConfig else { return }
+        
+        scanButton.isEnabled = false
+        
+        DispatchQueue.global(qos: .userInitiated).async { [weak self] in
+            if DecodeBenchmark.isRequested {
+                DecodeBenchmark(config: decoderConfig, threadLimits: DecodeBenchmark.requestedThreadLimits).run()
+            }
+            
+            if FrameReplay.isRequested {
+                FrameReplay(config: decoderConfig,
+                            traceURL: FrameReplay.isTraceRequested ? FrameReplay.defaultTraceURL : nil).run()
+            }
+            
+            DispatchQueue.main.async {
+                self?.scanButton.isEnabled = true
+            }
+        }
+    }
         
     // MARK: - IBActions
     